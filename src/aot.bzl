@@ -0,0 +1,32 @@
+"""Build rules for compiling classes ahead of time."""
+
+def jvm_aot_library(name, classes, **kwargs):
+    """Translates class files into C++ and compiles them into a library.
+
+    Linking the library into a binary registers the translated methods in
+    CompiledCode, where a future dispatcher can find them. There is no
+    interpreter yet, so methods the translator does not support are left out.
+
+    Args:
+      name: Name of the generated cc_library.
+      classes: Class files to translate, one source file each.
+      **kwargs: Passed through to the cc_library.
+    """
+    srcs = []
+    for class_file in classes:
+        out = name + "_" + class_file.split(":")[-1].split("/")[-1].replace(".class", ".cc")
+        native.genrule(
+            name = out.replace(".cc", "_aot"),
+            srcs = [class_file],
+            outs = [out],
+            cmd = "$(location //src:aot) $< > $@",
+            tools = ["//src:aot"],
+        )
+        srcs.append(out)
+    native.cc_library(
+        name = name,
+        srcs = srcs,
+        deps = ["//src:compiled"],
+        alwayslink = 1,
+        **kwargs
+    )
@@ -0,0 +1,50 @@
+#include "compiled.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include "isolate.h"
+#include "utilities.h"
+
+namespace {
+
+using namespace JVM;
+
+const auto readfile = [](const string& filename) -> string {
+  std::ifstream file(filename);
+  EXPECT_TRUE(file.is_open());
+  return string((std::istreambuf_iterator<char>(file)),
+                std::istreambuf_iterator<char>());
+};
+
+// Loop.run was translated by the :loop_aot rule and linked into this test.
+TEST(AotTests, Loop) {
+  auto classes = make_shared<ClassTable>();
+  auto main = classes->AddClass(readfile("test/Loop.class"));
+  Isolate isolate(classes);
+
+  EXPECT_EQ(CompiledCode::Find("Loop", "<init>", "()V"), nullptr);
+  const CompiledMethod* method = CompiledCode::Find("Loop", "run", "()V");
+  ASSERT_NE(method, nullptr);
+  reinterpret_cast<void (*)(uint8_t*)>(method->entry)(isolate.Statics(*main));
+
+  ASSERT_EQ(main->fields[0].name->bytes, "sum");
+  EXPECT_EQ(LoadStatic<int32_t>(isolate.Statics(*main), main->fields[0].offset),
+            45);
+}
+
+TEST(AotTests, Negate) {
+  EXPECT_TRUE(std::signbit(JavaNeg<float>(0.0f)));
+  EXPECT_TRUE(std::signbit(JavaNeg<double>(0.0)));
+  EXPECT_FALSE(std::signbit(JavaNeg<double>(-0.0)));
+  EXPECT_EQ(JavaNeg<int32_t>(std::numeric_limits<int32_t>::min()),
+            std::numeric_limits<int32_t>::min());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include "utilities.h"
 
 namespace JVM {
@@ -116,12 +118,55 @@ struct Exception {
   uint16_t catch_type;
 };
 
+struct Class;
+
+// An exception table entry prepared by the linker. A null catch_type catches
+// everything (as used by finally blocks). Otherwise catch_class is filled in
+// by the ClassTable once the catch type is loaded; until then no exception
+// can be an instance of it, so the handler never matches.
+//
+// The ClassTable resolves what it can before the class is shared, but the
+// catch type may be loaded afterwards, so catch_class is the one field written
+// late. It is atomic and only ever goes from null to its final value, stored
+// with release order and loaded with acquire order, so a reader sees either
+// a fully built class or no match. Copies are only made while linking, before
+// the class is shared.
+struct Handler {
+  Handler() = default;
+  Handler(const Handler& other) { *this = other; }
+  Handler& operator=(const Handler& other) {
+    start_pc = other.start_pc;
+    end_pc = other.end_pc;
+    handler_pc = other.handler_pc;
+    catch_type = other.catch_type;
+    catch_class.store(other.catch_class.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+    return *this;
+  }
+
+  uint16_t start_pc;
+  uint16_t end_pc;
+  uint16_t handler_pc;
+  shared_ptr<ClassConstant> catch_type;
+  std::atomic<const Class*> catch_class{nullptr};
+};
+
+// A maximal range of pcs [start_pc, end_pc) covered by the same handlers,
+// stored as indices into CodeAttribute::handlers in exception table order.
+struct HandlerRange {
+  uint16_t start_pc;
+  uint16_t end_pc;
+  vector<uint16_t> handlers;
+};
+
 struct CodeAttribute : public Attribute {
   uint16_t max_stack;
   uint16_t max_locals;
   vector<uint8_t> code;
   vector<Exception> exception_table;
-  vector<Attribute> attributes;
+  vector<shared_ptr<Attribute>> attributes;
+  vector<Handler> handlers;             // Filled in by the linker.
+  vector<HandlerRange> handler_ranges;  // Sorted and disjoint.
 };
 
 struct LineNumber {
@@ -138,6 +183,8 @@ struct SourceFileAttribute : public Attribute {
   shared_ptr<UnicodeConstant> file;
 };
 
+constexpr uint16_t kAccStatic = 0x0008;
+
 struct Field {
   uint16_t access_flags;
   uint16_t name_index;
@@ -145,6 +192,7 @@ struct Field {
   uint16_t type_index;
   shared_ptr<UnicodeConstant> type;
   vector<shared_ptr<Attribute>> attributes;
+  uint32_t offset = 0;  // Into the object, or the static block if ACC_STATIC.
 };
 
 struct Method {
@@ -154,6 +202,22 @@ struct Method {
   uint16_t type_index;
   shared_ptr<UnicodeConstant> type;
   vector<shared_ptr<Attribute>> attributes;
+  shared_ptr<CodeAttribute> code;  // Null for abstract and native methods.
+};
+
+// A run of consecutive reference slots, which the GC scans as a unit.
+struct ReferenceRange {
+  uint32_t offset;
+  uint32_t count;
+};
+
+// Where the values of a set of fields live, computed by the linker. Each
+// class appends its own fields to its superclass's layout: references first,
+// then primitives from largest to smallest, filling alignment gaps.
+struct Layout {
+  uint32_t size = 0;  // End of the last field, before rounding up.
+  vector<ReferenceRange> references;
+  vector<pair<uint32_t, uint32_t>> gaps;  // Unused [start, end) byte ranges.
 };
 
 struct Class {
@@ -169,6 +233,9 @@ struct Class {
   vector<Field> fields;
   vector<Method> methods;
   vector<shared_ptr<Attribute>> attributes;
+  Layout instance_layout;  // Includes the object header and inherited fields.
+  Layout static_layout;  // Storage is allocated per isolate.
+  const Class* super = nullptr;  // Null if the superclass was not linked.
 
  public:
   friend ostream& operator<<(ostream& os, const Class& main);
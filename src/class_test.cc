@@ -1,9 +1,18 @@
 #include "class.h"
 
+#include <chrono>
+#include <thread>
+
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include "isolate.h"
+#include "linker.h"
 #include "loader.h"
+#include "memory.h"
+#include "prefetcher.h"
+#include "translator.h"
+#include "unwinder.h"
 #include "utilities.h"
 
 namespace {
@@ -17,6 +26,23 @@ const auto readfile = [](const string& filename) -> string {
                 std::istreambuf_iterator<char>());
 };
 
+// A class with no members, for tests that need a hierarchy.
+const auto make_class = [](const string& name, const string& super) {
+  const auto constant = [](const string& name) {
+    auto unicode = make_shared<UnicodeConstant>();
+    unicode->tag = Constant::Type::Unicode;
+    unicode->bytes = name;
+    auto constant = make_shared<ClassConstant>();
+    constant->tag = Constant::Type::Class;
+    constant->name = unicode;
+    return constant;
+  };
+  Class main;
+  main.this_class = constant(name);
+  main.super_class = constant(super);
+  return main;
+};
+
 TEST(ParserTests, Hello) {
   string data = readfile("test/Hello.class");
   Class main = ClassLoader::LoadClass(data);
@@ -29,6 +55,313 @@ TEST(ParserTests, Simple) {
   std::cout << main << std::endl;
 }
 
+TEST(ParserTests, Catch) {
+  string data = readfile("test/Catch.class");
+  Class main = ClassLoader::LoadClass(data);
+  const Method& method = main.methods[2];
+  ASSERT_EQ(method.name->bytes, "main");
+  ASSERT_TRUE(method.code);
+  ASSERT_EQ(method.code->exception_table.size(), 1);
+  EXPECT_EQ(method.code->exception_table[0].start_pc, 0);
+  EXPECT_EQ(method.code->exception_table[0].end_pc, 3);
+  EXPECT_EQ(method.code->exception_table[0].handler_pc, 6);
+
+  // The StackMapTable is kept as a raw attribute.
+  ASSERT_EQ(method.code->attributes.size(), 2);
+  EXPECT_TRUE(dynamic_pointer_cast<LineNumberTableAttribute>(
+      method.code->attributes[0]));
+  EXPECT_EQ(method.code->attributes[1]->name->bytes, "StackMapTable");
+  EXPECT_FALSE(method.code->attributes[1]->bytes.empty());
+
+  ASSERT_EQ(method.code->handler_ranges.size(), 1);
+  EXPECT_EQ(method.code->handler_ranges[0].start_pc, 0);
+  EXPECT_EQ(method.code->handler_ranges[0].end_pc, 3);
+  EXPECT_EQ(method.code->handlers[0].catch_type->name->bytes,
+            "java/lang/IllegalStateException");
+}
+
+TEST(LinkerTests, HandlerRanges) {
+  vector<shared_ptr<Constant>> pool(3);
+  auto name = make_shared<UnicodeConstant>();
+  name->tag = Constant::Type::Unicode;
+  name->bytes = "java/lang/RuntimeException";
+  auto catch_class = make_shared<ClassConstant>();
+  catch_class->tag = Constant::Type::Class;
+  catch_class->name_index = 1;
+  catch_class->name = name;
+  pool[1] = name;
+  pool[2] = catch_class;
+
+  CodeAttribute code;
+  code.code.resize(40);
+  code.exception_table.push_back({0, 10, 20, 2});
+  code.exception_table.push_back({5, 15, 30, 0});
+  Linker::IndexHandlers(code, pool);
+
+  ASSERT_EQ(code.handler_ranges.size(), 3);
+  EXPECT_EQ(code.handler_ranges[0].start_pc, 0);
+  EXPECT_EQ(code.handler_ranges[0].handlers, vector<uint16_t>({0}));
+  EXPECT_EQ(code.handler_ranges[1].start_pc, 5);
+  EXPECT_EQ(code.handler_ranges[1].handlers, vector<uint16_t>({0, 1}));
+  EXPECT_EQ(code.handler_ranges[2].start_pc, 10);
+  EXPECT_EQ(code.handler_ranges[2].end_pc, 15);
+  EXPECT_EQ(code.handler_ranges[2].handlers, vector<uint16_t>({1}));
+  EXPECT_EQ(code.handlers[0].catch_type, catch_class);
+
+  Class exception = make_class("java/lang/RuntimeException", "");
+  Class subclass = make_class("Sub", "java/lang/RuntimeException");
+  subclass.super = &exception;
+  Class other = make_class("Other", "java/lang/Object");
+  code.handlers[0].catch_class = &exception;
+  EXPECT_EQ(Unwinder::FindHandler(code, 7, exception)->handler_pc, 20);
+  EXPECT_EQ(Unwinder::FindHandler(code, 7, subclass)->handler_pc, 20);
+  EXPECT_EQ(Unwinder::FindHandler(code, 7, other)->handler_pc, 30);
+  EXPECT_EQ(Unwinder::FindHandler(code, 3, other), nullptr);
+  EXPECT_EQ(Unwinder::FindHandler(code, 15, exception), nullptr);
+}
+
+TEST(LinkerTests, StaticLayout) {
+  string data = readfile("test/Simple.class");
+  Class main = ClassLoader::LoadClass(data);
+  // field2 is the only reference, so it leads the block and the two ints
+  // share the following eight bytes.
+  EXPECT_EQ(main.fields[1].offset, 0);
+  EXPECT_EQ(main.fields[0].offset, Linker::kReferenceSize);
+  EXPECT_EQ(main.fields[2].offset, Linker::kReferenceSize + 4);
+  EXPECT_EQ(main.static_layout.size, Linker::kReferenceSize + 8);
+  ASSERT_EQ(main.static_layout.references.size(), 1);
+  EXPECT_EQ(main.static_layout.references[0].count, 1);
+  EXPECT_EQ(main.instance_layout.size, Linker::kHeaderSize);
+}
+
+TEST(LinkerTests, InstanceLayout) {
+  const auto field = [](const string& type) {
+    Field field;
+    field.access_flags = 0;
+    field.type = make_shared<UnicodeConstant>();
+    field.type->tag = Constant::Type::Unicode;
+    field.type->bytes = type;
+    return field;
+  };
+  Class super;
+  super.fields = {field("I"), field("B")};
+  Linker::LayoutFields(super, nullptr);
+  EXPECT_EQ(super.fields[0].offset, 8);
+  EXPECT_EQ(super.fields[1].offset, 12);
+  EXPECT_EQ(super.instance_layout.size, 13);
+
+  Class main;
+  main.fields = {field("J"), field("Ljava/lang/Object;"), field("S"),
+                 field("Z"), field("[I")};
+  Linker::LayoutFields(main, &super);
+  EXPECT_EQ(main.fields[1].offset, 16);
+  EXPECT_EQ(main.fields[4].offset, 16 + Linker::kReferenceSize);
+  EXPECT_EQ(main.fields[0].offset, 16 + 2 * Linker::kReferenceSize);
+  EXPECT_EQ(main.fields[2].offset, 14);  // Fills the gap after the byte.
+  EXPECT_EQ(main.fields[3].offset, 13);
+  EXPECT_EQ(main.instance_layout.size, 24 + 2 * Linker::kReferenceSize);
+  ASSERT_EQ(main.instance_layout.references.size(), 1);
+  EXPECT_EQ(main.instance_layout.references[0].count, 2);
+  EXPECT_TRUE(main.instance_layout.gaps.empty());
+}
+
+TEST(UnwinderTests, Simple) {
+  string data = readfile("test/Simple.class");
+  Class main = ClassLoader::LoadClass(data);
+  const Method& method = main.methods[2];
+  ASSERT_EQ(method.name->bytes, "main");
+  ASSERT_TRUE(method.code);
+
+  vector<Frame> frames = {{&main, &method, 0}};
+  StackTrace trace(frames);
+  auto elements = trace.Symbolize();
+  ASSERT_EQ(elements.size(), 1);
+  EXPECT_EQ(elements[0].class_name, "Simple");
+  EXPECT_EQ(elements[0].method_name, "main");
+  EXPECT_EQ(elements[0].file, "Simple.java");
+  EXPECT_EQ(elements[0].line, 10);
+  std::cout << trace;
+
+  EXPECT_FALSE(Unwinder::Unwind(frames, main));
+  EXPECT_TRUE(frames.empty());
+}
+
+TEST(UnwinderTests, Catch) {
+  // The catch type may be loaded before or after the class that catches it.
+  for (bool catch_type_first : {true, false}) {
+    ClassTable classes;
+    shared_ptr<const Class> exception;
+    if (catch_type_first)
+      exception = classes.AddClass(
+          make_class("java/lang/IllegalStateException", "java/lang/Object"));
+    auto main = classes.AddClass(readfile("test/Catch.class"));
+    if (!catch_type_first)
+      exception = classes.AddClass(
+          make_class("java/lang/IllegalStateException", "java/lang/Object"));
+    auto subclass = classes.AddClass(
+        make_class("Sub", "java/lang/IllegalStateException"));
+    auto other = classes.AddClass(make_class("Other", "java/lang/Object"));
+    const Method& fail = main->methods[1];
+    const Method& method = main->methods[2];
+    EXPECT_EQ(method.code->handlers[0].catch_class.load(), exception.get());
+
+    // Thrown from fail() while main is at the call.
+    vector<Frame> frames = {{main.get(), &method, 0},
+                            {main.get(), &fail, 7}};
+    EXPECT_TRUE(Unwinder::Unwind(frames, *subclass));
+    ASSERT_EQ(frames.size(), 1);
+    EXPECT_EQ(frames[0].pc, 6);
+
+    frames = {{main.get(), &method, 0}, {main.get(), &fail, 7}};
+    EXPECT_FALSE(Unwinder::Unwind(frames, *other));
+    EXPECT_TRUE(frames.empty());
+  }
+}
+
+TEST(IsolateTests, Simple) {
+  auto classes = make_shared<ClassTable>();
+  auto main = classes->AddClass(readfile("test/Simple.class"));
+  EXPECT_EQ(classes->FindClass("Simple"), main);
+  EXPECT_EQ(classes->FindClass("Hello"), nullptr);
+  EXPECT_THROW(classes->AddClass(readfile("test/Simple.class")),
+               std::runtime_error);
+  EXPECT_THROW(classes->AddClass(make_class("Sub", "Super")),
+               std::runtime_error);
+  classes->AddClass(make_class("Super", "java/lang/Object"));
+  EXPECT_TRUE(classes->AddClass(make_class("Sub", "Super")));
+
+  Isolate first(classes);
+  Isolate second(classes);
+  EXPECT_EQ(&first.classes(), &second.classes());
+  uint32_t offset = main->fields[0].offset;
+  first.Statics(*main)[offset] = 42;
+  EXPECT_EQ(first.Statics(*main)[offset], 42);
+  EXPECT_EQ(second.Statics(*main)[offset], 0);
+
+  const string& interned = first.Intern("Simple.java");
+  EXPECT_EQ(&first.Intern("Simple.java"), &interned);
+  EXPECT_NE(&second.Intern("Simple.java"), &interned);
+}
+
+TEST(PrefetcherTests, Classpath) {
+  ClassPrefetcher prefetcher({"missing", "test"}, 2, 16);
+  prefetcher.Prefetch("Simple");
+  auto simple = prefetcher.TakeClass("Simple");
+  ASSERT_TRUE(simple);
+  EXPECT_EQ(simple->this_class->name->bytes, "Simple");
+  EXPECT_EQ(prefetcher.TakeClass("Simple"), nullptr);
+
+  auto hello = prefetcher.TakeClass("Hello");
+  ASSERT_TRUE(hello);
+  EXPECT_EQ(prefetcher.TakeClass("Missing"), nullptr);
+
+  // Simple refers to java/lang/Object, which is not on the classpath. Give a
+  // worker time to look for it, so the take usually finds a done, empty entry.
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  PrefetchStats before = prefetcher.stats();
+  EXPECT_EQ(prefetcher.TakeClass("java/lang/Object"), nullptr);
+  PrefetchStats stats = prefetcher.stats();
+  EXPECT_EQ(stats.hits, before.hits);
+  EXPECT_EQ(stats.misses, before.misses + 1);
+  EXPECT_EQ(stats.hits + stats.waits + stats.misses, 5);
+  EXPECT_GE(stats.misses, 3);  // Hello, Missing and java/lang/Object.
+  EXPECT_LE(stats.prefetched, 1);  // Only Simple was found.
+
+  ClassTable classes;
+  ClassPrefetcher other({"test"}, 1, 16);
+  auto loaded = classes.LoadClass("Simple", other);
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(classes.FindClass("Simple"), loaded);
+  EXPECT_EQ(classes.LoadClass("Simple", other), loaded);
+}
+
+TEST(PrefetcherTests, Capacity) {
+  ClassPrefetcher prefetcher({"test"}, 1, 0);
+  prefetcher.Prefetch("Simple");
+  EXPECT_TRUE(prefetcher.TakeClass("Simple"));
+  PrefetchStats stats = prefetcher.stats();
+  EXPECT_GE(stats.skipped, 1);  // Simple, and the classes it refers to.
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.prefetched, 0);
+}
+
+TEST(PrefetcherTests, MissingSuperclass) {
+  // A copy of Simple whose superclass is renamed to one that does not exist.
+  string data = readfile("test/Simple.class");
+  string object = "java/lang/Object";
+  data.replace(data.find(object), object.size(), "java/lang/Objecu");
+  string directory = ::testing::TempDir();
+  std::ofstream(directory + "/Simple.class", std::ios::binary) << data;
+
+  ClassTable classes;
+  ClassPrefetcher prefetcher({directory}, 1, 16);
+  EXPECT_EQ(classes.LoadClass("Simple", prefetcher), nullptr);
+  EXPECT_EQ(classes.FindClass("Simple"), nullptr);
+}
+
+TEST(MemoryTests, Simple) {
+  auto classes = make_shared<ClassTable>();
+  auto simple = classes->AddClass(readfile("test/Simple.class"));
+  auto hello = classes->AddClass(readfile("test/Hello.class"));
+  Isolate isolate(classes);
+  isolate.Statics(*simple);
+
+  ClassMemory memory = MemoryAccounting::MeasureClass(*simple);
+  EXPECT_EQ(memory.name, "Simple");
+  EXPECT_GT(memory.constant_pool, simple->constant_pool.size() * 8);
+  EXPECT_GT(memory.strings, 0);  // "([Ljava/lang/String;)V" is not short.
+  EXPECT_GT(memory.code, 0);
+  EXPECT_GT(memory.attributes, 0);
+  EXPECT_GE(memory.metadata, sizeof(Class));
+  EXPECT_EQ(memory.statics, simple->static_layout.size);
+
+  MemoryReport table = MemoryAccounting::MeasureTable(*classes);
+  EXPECT_FALSE(table.isolate);
+  ASSERT_EQ(table.classes.size(), 2);
+  EXPECT_GE(table.classes[0].total(), table.classes[1].total());
+  MemoryAccounting::PrintReport(std::cout, table);
+
+  // Only Simple's statics have been allocated in the isolate.
+  isolate.Intern("a string too long to be stored inline");
+  MemoryReport report = MemoryAccounting::MeasureIsolate(isolate);
+  EXPECT_TRUE(report.isolate);
+  EXPECT_GT(report.interned, 38);
+  ASSERT_EQ(report.classes.size(), 2);
+  for (const ClassMemory& entry : report.classes) {
+    if (entry.name == "Simple")
+      EXPECT_EQ(entry.statics, simple->static_layout.size);
+    else
+      EXPECT_EQ(entry.statics, 0);
+  }
+  MemoryAccounting::PrintReport(std::cout, report);
+}
+
+TEST(TranslatorTests, Simple) {
+  string data = readfile("test/Simple.class");
+  Class main = ClassLoader::LoadClass(data);
+  ASSERT_EQ(main.methods[1].name->bytes, "foo");
+  // for (int i = 0; i < 10; ++i) field1 += i;
+  main.methods[1].code->code = {
+      0x03, 0x3b, 0x1a, 0x10, 0x0a, 0xa2, 0x00, 0x11, 0xb2, 0x00, 0x03, 0x1a,
+      0x60, 0xb3, 0x00, 0x03, 0x84, 0x00, 0x01, 0xa7, 0xff, 0xef, 0xb1};
+  string source = Translator::TranslateClass(main);
+  std::cout << source;
+  EXPECT_NE(source.find("Simple.<init>()V is not translated"), string::npos);
+  EXPECT_NE(source.find("Simple.main([Ljava/lang/String;)V is not translated"),
+            string::npos);
+  EXPECT_NE(source.find("void Simple__foo_1(uint8_t* statics) {"),
+            string::npos);
+  EXPECT_NE(source.find("pc2:"), string::npos);
+  EXPECT_NE(source.find("goto pc22;"), string::npos);
+  EXPECT_NE(source.find("LoadStatic<int32_t>(statics, " +
+                        std::to_string(main.fields[0].offset) + ')'),
+            string::npos);
+
+  // The goto lands on the operand of bipush rather than an instruction.
+  main.methods[1].code->code[21] = 0xf1;
+  EXPECT_THROW(Translator::TranslateClass(main), InvalidFormatError);
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
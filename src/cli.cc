@@ -1,29 +1,52 @@
 // Command line interface for the JVM
 
 #include "class.h"
+#include "isolate.h"
 #include "loader.h"
+#include "memory.h"
 #include "utilities.h"
 
 using namespace JVM;
 
+string ReadFile(const char* filename) {
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    std::cerr << "Unable to open file " << filename << std::endl;
+    exit(1);
+  }
+  return string((std::istreambuf_iterator<char>(file)),
+                std::istreambuf_iterator<char>());
+}
+
 int main(int argc, char* argv[]) {
   string binary_name = argv[0];
+  bool memory = argc > 1 && string(argv[1]) == "--memory";
 
   // Check usage:
-  if (argc != 2) {
+  if (memory ? argc < 3 : argc != 2) {
     std::cerr << "Usage: " << binary_name << " foo.class" << std::endl;
+    std::cerr << "       " << binary_name << " --memory foo.class..."
+              << std::endl;
     exit(1);
   }
 
-  // Read from file given as argv[1]
-  std::ifstream file(argv[1]);
-  if (!file.is_open()) {
-    std::cerr << "Unable to open file " << argv[1] << std::endl;
-    exit(1);
+  // Report the memory used by each class given, superclasses first
+  if (memory) {
+    ClassTable classes;
+    try {
+      for (int index = 2; index < argc; ++index)
+        classes.AddClass(ReadFile(argv[index]));
+    } catch (const std::runtime_error& error) {
+      std::cerr << error.what() << std::endl;
+      exit(1);
+    }
+    MemoryAccounting::PrintReport(std::cout,
+                                  MemoryAccounting::MeasureTable(classes));
+    return 0;
   }
-  string data((std::istreambuf_iterator<char>(file)),
-              std::istreambuf_iterator<char>());
 
+  // Read from file given as argv[1]
+  string data = ReadFile(argv[1]);
   Class main_class = ClassLoader::LoadClass(data);
   std::cout << main_class << std::endl;
 }
@@ -0,0 +1,34 @@
+#include "compiled.h"
+
+#include <map>
+#include <tuple>
+
+namespace JVM {
+
+namespace {
+
+using Key = std::tuple<string, string, string>;
+
+std::map<Key, const CompiledMethod*>& Registry() {
+  static auto* registry = new std::map<Key, const CompiledMethod*>();
+  return *registry;
+}
+
+}  // namespace
+
+bool CompiledCode::Register(const CompiledMethod* methods, size_t count) {
+  for (size_t index = 0; index < count; ++index) {
+    const CompiledMethod& method = methods[index];
+    Registry()[{method.class_name, method.name, method.descriptor}] = &method;
+  }
+  return true;
+}
+
+const CompiledMethod* CompiledCode::Find(const string& class_name,
+                                         const string& name,
+                                         const string& descriptor) {
+  auto found = Registry().find({class_name, name, descriptor});
+  return found == Registry().end() ? nullptr : found->second;
+}
+
+}  // namespace JVM
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "utilities.h"
+
+namespace JVM {
+
+// A method translated ahead of time into C++ by the aot tool. The entry takes
+// the static field block of its class followed by the method's arguments,
+// and must be cast back to that signature before it is called.
+struct CompiledMethod {
+  const char* class_name;
+  const char* name;
+  const char* descriptor;
+  void (*entry)();
+};
+
+class CompiledCode {
+ public:
+  // Called from the static initialisers of generated sources.
+  static bool Register(const CompiledMethod* methods, size_t count);
+
+  // The compiled code for a method, or null if it was not translated.
+  static const CompiledMethod* Find(const string& class_name,
+                                    const string& name,
+                                    const string& descriptor);
+};
+
+// Java semantics for the operations generated code performs, where they
+// differ from C++ (signed overflow, shift distances, NaN handling, and
+// out-of-range floating point conversions).
+
+template <typename T>
+T LoadStatic(const uint8_t* statics, uint32_t offset) {
+  T value;
+  std::memcpy(&value, statics + offset, sizeof(T));
+  return value;
+}
+
+template <typename T>
+void StoreStatic(uint8_t* statics, uint32_t offset, T value) {
+  std::memcpy(statics + offset, &value, sizeof(T));
+}
+
+template <typename T, typename Bits>
+T FromBits(Bits bits) {
+  static_assert(sizeof(T) == sizeof(Bits));
+  T value;
+  std::memcpy(&value, &bits, sizeof(T));
+  return value;
+}
+
+template <typename T>
+T JavaAdd(T left, T right) {
+  if constexpr (std::is_integral_v<T>) {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<T>(static_cast<U>(left) + static_cast<U>(right));
+  } else {
+    return left + right;
+  }
+}
+
+template <typename T>
+T JavaSub(T left, T right) {
+  if constexpr (std::is_integral_v<T>) {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<T>(static_cast<U>(left) - static_cast<U>(right));
+  } else {
+    return left - right;
+  }
+}
+
+template <typename T>
+T JavaMul(T left, T right) {
+  if constexpr (std::is_integral_v<T>) {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<T>(static_cast<U>(left) * static_cast<U>(right));
+  } else {
+    return left * right;
+  }
+}
+
+template <typename T>
+T JavaNeg(T value) {
+  // Negating zero must give -0.0, which 0 - value does not.
+  if constexpr (std::is_floating_point_v<T>) {
+    return -value;
+  } else {
+    return JavaSub<T>(0, value);
+  }
+}
+
+template <typename T>
+T JavaShl(T value, int32_t distance) {
+  using U = std::make_unsigned_t<T>;
+  return static_cast<T>(static_cast<U>(value)
+                        << (distance & (sizeof(T) * 8 - 1)));
+}
+
+template <typename T>
+T JavaShr(T value, int32_t distance) {
+  return value >> (distance & (sizeof(T) * 8 - 1));
+}
+
+template <typename T>
+T JavaUshr(T value, int32_t distance) {
+  using U = std::make_unsigned_t<T>;
+  return static_cast<T>(static_cast<U>(value) >>
+                        (distance & (sizeof(T) * 8 - 1)));
+}
+
+// fcmpl and dcmpl return -1 on NaN, fcmpg and dcmpg return 1.
+template <typename T>
+int32_t JavaCompare(T left, T right, int32_t nan) {
+  if (left > right) return 1;
+  if (left < right) return -1;
+  if (left == right) return 0;
+  return nan;
+}
+
+template <typename To, typename From>
+To JavaConvert(From value) {
+  if constexpr (std::is_integral_v<To> && std::is_floating_point_v<From>) {
+    if (std::isnan(value)) return 0;
+    if (value <= static_cast<From>(std::numeric_limits<To>::min()))
+      return std::numeric_limits<To>::min();
+    if (value >= static_cast<From>(std::numeric_limits<To>::max()))
+      return std::numeric_limits<To>::max();
+  }
+  return static_cast<To>(value);
+}
+
+}  // namespace JVM
@@ -0,0 +1,96 @@
+#include "isolate.h"
+
+#include "linker.h"
+#include "loader.h"
+
+namespace JVM {
+
+shared_ptr<const Class> ClassTable::AddClass(const string& source) {
+  return AddClass(ClassLoader::ParseClass(source));
+}
+
+shared_ptr<const Class> ClassTable::AddClass(Class main) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  return AddLocked(std::move(main));
+}
+
+shared_ptr<const Class> ClassTable::LoadClass(const string& name,
+                                              ClassPrefetcher& prefetcher) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  return LoadLocked(name, prefetcher);
+}
+
+shared_ptr<const Class> ClassTable::FindClass(const string& name) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return FindLocked(name);
+}
+
+shared_ptr<const Class> ClassTable::AddLocked(Class main) {
+  string name = main.this_class->name->bytes;
+  if (classes_.count(name))
+    throw std::runtime_error("Class " + name + " is already loaded.");
+  const string& super_name = main.super_class->name->bytes;
+  auto super = FindLocked(super_name);
+  if (!super && super_name != "java/lang/Object")
+    throw std::runtime_error("Superclass " + super_name + " of " + name +
+                             " is not loaded.");
+  Linker::LinkClass(main, super.get());
+  // The class's own handlers are resolved before it is shared. Handlers live
+  // in the method's CodeAttribute, so the pointers kept for the ones still
+  // waiting survive the move below.
+  ResolveHandlers(main);
+  auto loaded = make_shared<const Class>(std::move(main));
+  classes_[name] = loaded;
+  auto waiting = unresolved_.equal_range(name);
+  for (auto handler = waiting.first; handler != waiting.second; ++handler)
+    handler->second->catch_class.store(loaded.get(), std::memory_order_release);
+  unresolved_.erase(waiting.first, waiting.second);
+  return loaded;
+}
+
+void ClassTable::ResolveHandlers(const Class& main) {
+  for (const Method& method : main.methods) {
+    if (!method.code) continue;
+    for (Handler& handler : method.code->handlers) {
+      if (!handler.catch_type) continue;
+      const string& catch_name = handler.catch_type->name->bytes;
+      if (auto catch_class = FindLocked(catch_name)) {
+        handler.catch_class.store(catch_class.get(), std::memory_order_relaxed);
+      } else {
+        unresolved_.emplace(catch_name, &handler);
+      }
+    }
+  }
+}
+
+shared_ptr<const Class> ClassTable::LoadLocked(const string& name,
+                                               ClassPrefetcher& prefetcher) {
+  if (auto loaded = FindLocked(name)) return loaded;
+  unique_ptr<Class> main = prefetcher.TakeClass(name);
+  if (!main) return nullptr;
+  const string& super_name = main->super_class->name->bytes;
+  if (super_name != "java/lang/Object" && !LoadLocked(super_name, prefetcher))
+    return nullptr;
+  return AddLocked(std::move(*main));
+}
+
+shared_ptr<const Class> ClassTable::FindLocked(const string& name) const {
+  auto found = classes_.find(name);
+  return found == classes_.end() ? nullptr : found->second;
+}
+
+uint8_t* Isolate::Statics(const Class& main) {
+  auto& statics = statics_[&main];
+  if (!statics) statics.reset(new uint8_t[main.static_layout.size]());
+  return statics.get();
+}
+
+size_t Isolate::StaticsSize(const Class& main) const {
+  return statics_.count(&main) ? main.static_layout.size : 0;
+}
+
+const string& Isolate::Intern(const string& value) {
+  return *strings_.insert(value).first;
+}
+
+}  // namespace JVM
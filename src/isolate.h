@@ -0,0 +1,90 @@
+#pragma once
+
+#include <map>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "class.h"
+#include "prefetcher.h"
+#include "utilities.h"
+
+namespace JVM {
+
+// Parsed and linked classes, which are immutable once added and can be shared
+// by any number of isolates.
+//
+// Threading: every method may be called from any thread. Lookups share a
+// lock, while adding or loading a class holds it exclusively, so a class and
+// its superclasses are taken from the prefetcher and linked by one thread at
+// a time. The map returned by classes() is not guarded and may only be used
+// while no classes are being added.
+class ClassTable {
+ public:
+  // Load a class and add it to the table. Its superclass must have been added
+  // first, unless it is java/lang/Object, so that the inherited layout is
+  // known.
+  shared_ptr<const Class> AddClass(const string& source);
+
+  // Link a class whose constants have been traced and add it to the table.
+  shared_ptr<const Class> AddClass(Class main);
+
+  // Load the class with the given internal name, and its superclasses, from
+  // the prefetcher, which has usually parsed them in the background already.
+  // Returns null if the class or one of its superclasses is not on the
+  // classpath.
+  shared_ptr<const Class> LoadClass(const string& name,
+                                    ClassPrefetcher& prefetcher);
+
+  // The class with the given internal name, or null if it is not loaded.
+  shared_ptr<const Class> FindClass(const string& name) const;
+
+  const std::map<string, shared_ptr<const Class>>& classes() const {
+    return classes_;
+  }
+
+ private:
+  // The unlocked versions of the methods above, called with mutex_ held.
+  shared_ptr<const Class> AddLocked(Class main);
+  shared_ptr<const Class> LoadLocked(const string& name,
+                                     ClassPrefetcher& prefetcher);
+  shared_ptr<const Class> FindLocked(const string& name) const;
+
+  // Resolve the catch types of a class's handlers that are already loaded, and
+  // queue the others in unresolved_ until their class is added.
+  void ResolveHandlers(const Class& main);
+
+  mutable std::shared_mutex mutex_;
+  std::map<string, shared_ptr<const Class>> classes_;
+  // Handlers whose catch type has not been loaded yet, by its name.
+  std::multimap<string, Handler*> unresolved_;
+};
+
+// An independent program running on a shared ClassTable. Everything a program
+// can change lives here, so creating an isolate only costs a few empty
+// containers; static storage is allocated when a class is first used.
+class Isolate {
+ public:
+  explicit Isolate(shared_ptr<const ClassTable> classes)
+      : classes_(std::move(classes)) {}
+
+  const ClassTable& classes() const { return *classes_; }
+
+  // The zero-initialised static field block of the class in this isolate.
+  uint8_t* Statics(const Class& main);
+
+  // Bytes of static storage allocated for the class, or 0 if it is unused.
+  size_t StaticsSize(const Class& main) const;
+
+  // The canonical copy of the string in this isolate's intern table.
+  const string& Intern(const string& value);
+
+  const std::unordered_set<string>& strings() const { return strings_; }
+
+ private:
+  shared_ptr<const ClassTable> classes_;
+  std::unordered_map<const Class*, unique_ptr<uint8_t[]>> statics_;
+  std::unordered_set<string> strings_;
+};
+
+}  // namespace JVM
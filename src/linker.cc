@@ -0,0 +1,183 @@
+#include "linker.h"
+
+#include <algorithm>
+
+namespace JVM {
+
+namespace {
+
+uint32_t Align(uint32_t offset, uint32_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+// Place a value of the given size in the layout, reusing an alignment gap if
+// one is large enough.
+uint32_t Allocate(Layout& layout, uint32_t size, bool fill_gaps) {
+  if (fill_gaps) {
+    for (auto gap = layout.gaps.begin(); gap != layout.gaps.end(); ++gap) {
+      uint32_t start = Align(gap->first, size);
+      if (start + size > gap->second) continue;
+      pair<uint32_t, uint32_t> before = {gap->first, start};
+      pair<uint32_t, uint32_t> after = {start + size, gap->second};
+      gap = layout.gaps.erase(gap);
+      if (after.first < after.second) gap = layout.gaps.insert(gap, after);
+      if (before.first < before.second) layout.gaps.insert(gap, before);
+      return start;
+    }
+  }
+  uint32_t start = Align(layout.size, size);
+  if (start > layout.size) layout.gaps.push_back({layout.size, start});
+  layout.size = start + size;
+  return start;
+}
+
+// Append the fields to the layout. References are allocated first and never
+// go into gaps, so that each class's references form a single range.
+void AppendFields(Layout& layout, const vector<Field*>& fields) {
+  vector<Field*> primitives;
+  for (Field* field : fields) {
+    if (!Linker::IsReference(field->type->bytes)) {
+      primitives.push_back(field);
+      continue;
+    }
+    field->offset = Allocate(layout, Linker::kReferenceSize, false);
+    auto& references = layout.references;
+    if (!references.empty() &&
+        references.back().offset +
+                references.back().count * Linker::kReferenceSize ==
+            field->offset) {
+      ++references.back().count;
+    } else {
+      references.push_back({field->offset, 1});
+    }
+  }
+  std::stable_sort(primitives.begin(), primitives.end(),
+                   [](const Field* left, const Field* right) {
+                     return Linker::FieldSize(left->type->bytes) >
+                            Linker::FieldSize(right->type->bytes);
+                   });
+  for (Field* field : primitives) {
+    field->offset =
+        Allocate(layout, Linker::FieldSize(field->type->bytes), true);
+  }
+}
+
+}  // namespace
+
+void Linker::LinkClass(Class& main, const Class* super) {
+  main.super = super;
+  LayoutFields(main, super);
+  for (Method& method : main.methods) {
+    for (const shared_ptr<Attribute>& attribute : method.attributes) {
+      if (auto code = dynamic_pointer_cast<CodeAttribute>(attribute)) {
+        if (method.code)
+          throw InvalidFormatError("A method must have at most one Code.");
+        method.code = code;
+      }
+    }
+    if (method.code) IndexHandlers(*method.code, main.constant_pool);
+  }
+}
+
+bool Linker::IsReference(const string& descriptor) {
+  return !descriptor.empty() &&
+         (descriptor.front() == 'L' || descriptor.front() == '[');
+}
+
+uint32_t Linker::FieldSize(const string& descriptor) {
+  if (descriptor.empty())
+    throw InvalidFormatError("Invalid field descriptor.");
+  switch (descriptor.front()) {
+    case 'B':
+    case 'Z':
+      return 1;
+    case 'C':
+    case 'S':
+      return 2;
+    case 'I':
+    case 'F':
+      return 4;
+    case 'J':
+    case 'D':
+      return 8;
+    case 'L':
+    case '[':
+      return kReferenceSize;
+    default:
+      throw InvalidFormatError("Invalid field descriptor.");
+  }
+}
+
+void Linker::LayoutFields(Class& main, const Class* super) {
+  vector<Field*> instance_fields;
+  vector<Field*> static_fields;
+  for (Field& field : main.fields) {
+    if (field.access_flags & kAccStatic) {
+      static_fields.push_back(&field);
+    } else {
+      instance_fields.push_back(&field);
+    }
+  }
+  if (super) {
+    main.instance_layout = super->instance_layout;
+  } else {
+    main.instance_layout = Layout();
+    main.instance_layout.size = kHeaderSize;
+  }
+  AppendFields(main.instance_layout, instance_fields);
+  main.static_layout = Layout();
+  AppendFields(main.static_layout, static_fields);
+}
+
+void Linker::IndexHandlers(CodeAttribute& code,
+                           const vector<shared_ptr<Constant>>& pool) {
+  code.handlers.clear();
+  code.handler_ranges.clear();
+  vector<uint16_t> bounds;
+  for (const Exception& exception : code.exception_table) {
+    if (exception.start_pc >= exception.end_pc ||
+        exception.end_pc > code.code.size() ||
+        exception.handler_pc >= code.code.size())
+      throw InvalidFormatError("Invalid exception table entry.");
+    Handler handler;
+    handler.start_pc = exception.start_pc;
+    handler.end_pc = exception.end_pc;
+    handler.handler_pc = exception.handler_pc;
+    if (exception.catch_type != 0) {
+      if (exception.catch_type >= pool.size())
+        throw InvalidFormatError("Invalid constant pool entry.");
+      handler.catch_type =
+          dynamic_pointer_cast<ClassConstant>(pool[exception.catch_type]);
+      if (!handler.catch_type)
+        throw InvalidFormatError("Invalid constant pool entry.");
+    }
+    code.handlers.push_back(std::move(handler));
+    bounds.push_back(exception.start_pc);
+    bounds.push_back(exception.end_pc);
+  }
+  std::sort(bounds.begin(), bounds.end());
+  bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+  // Every handler begins and ends on a bound, so each elementary range between
+  // two consecutive bounds is either fully covered by a handler or not at all.
+  for (size_t bound = 1; bound < bounds.size(); ++bound) {
+    HandlerRange range;
+    range.start_pc = bounds[bound - 1];
+    range.end_pc = bounds[bound];
+    for (uint16_t index = 0; index < code.handlers.size(); ++index) {
+      const Handler& handler = code.handlers[index];
+      if (handler.start_pc <= range.start_pc && range.end_pc <= handler.end_pc)
+        range.handlers.push_back(index);
+    }
+    if (range.handlers.empty()) continue;
+    if (!code.handler_ranges.empty() &&
+        code.handler_ranges.back().end_pc == range.start_pc &&
+        code.handler_ranges.back().handlers == range.handlers) {
+      code.handler_ranges.back().end_pc = range.end_pc;
+    } else {
+      code.handler_ranges.push_back(std::move(range));
+    }
+  }
+}
+
+}  // namespace JVM
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "class.h"
+#include "parser.h"
+#include "utilities.h"
+
+namespace JVM {
+
+class Linker {
+ public:
+  // Size of the header at the start of every object, and of a reference.
+  static constexpr uint32_t kHeaderSize = 8;
+  static constexpr uint32_t kReferenceSize = sizeof(void*);
+
+  // Prepare a class whose constants have been traced for execution. Work that
+  // would otherwise be repeated every time a method runs is done here once.
+  // The superclass must already be linked; it is null only for the root of
+  // the hierarchy, or where instance layouts do not matter.
+  static void LinkClass(Class& main, const Class* super);
+
+  static bool IsReference(const string& descriptor);
+
+  // Number of bytes a field with the given descriptor occupies, which is also
+  // its alignment.
+  static uint32_t FieldSize(const string& descriptor);
+
+  // Assign offsets to the instance fields, appended to the superclass's
+  // layout, and to the static fields, in a block of their own.
+  static void LayoutFields(Class& main, const Class* super);
+
+  // Resolve the catch types of the method's exception table and split its pcs
+  // into disjoint ranges, so that finding the handlers for a pc is a binary
+  // search rather than a scan of the whole table.
+  static void IndexHandlers(CodeAttribute& code,
+                            const vector<shared_ptr<Constant>>& pool);
+};
+
+}  // namespace JVM
@@ -1,3 +1,12 @@
 #include "loader.h"
 
-namespace JVM {}  // namespace JVM
+namespace JVM {
+
+Class ClassLoader::ParseClass(const string& source) {
+  string remaining = source;
+  Class main = Parser::ParseClass(remaining);
+  Parser::TraceConstants(main);
+  return main;
+}
+
+}  // namespace JVM
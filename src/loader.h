@@ -1,6 +1,7 @@
 #pragma once
 
 #include "class.h"
+#include "linker.h"
 #include "parser.h"
 #include "utilities.h"
 
@@ -8,9 +9,15 @@ namespace JVM {
 
 class ClassLoader {
  public:
+  // Parse a class file and trace its constants, leaving it ready to link.
+  static Class ParseClass(const string& source);
+
+  // Load a single class on its own. It is linked without its superclass, so
+  // its instance layout is only correct if it extends java/lang/Object
+  // directly; use a ClassTable to load classes together with their parents.
   static Class LoadClass(const string& source) {
-    auto main = Parser::ParseClass(*make_unique<string>(source));
-    Parser::TraceConstants(main);
+    auto main = ParseClass(source);
+    Linker::LinkClass(main, nullptr);
     return main;
   }
 };
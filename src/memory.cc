@@ -0,0 +1,187 @@
+#include "memory.h"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace JVM {
+
+namespace {
+
+// The reference counts and vtable pointer make_shared stores next to the
+// object it allocates.
+constexpr size_t kControlBlockSize = sizeof(void*) + 2 * sizeof(int);
+
+// A node of an unordered_set<string>: the next pointer, the string and its
+// cached hash.
+constexpr size_t kHashNodeSize =
+    sizeof(void*) + sizeof(string) + sizeof(size_t);
+
+// Characters held outside the string object, which short strings avoid.
+size_t HeapSize(const string& value) {
+  const char* begin = reinterpret_cast<const char*>(&value);
+  const char* data = value.data();
+  if (data >= begin && data < begin + sizeof(value)) return 0;
+  return value.capacity() + 1;
+}
+
+template <typename T>
+size_t HeapSize(const vector<T>& values) {
+  return values.capacity() * sizeof(T);
+}
+
+size_t ConstantSize(const Constant& constant) {
+  switch (constant.tag) {
+    case Constant::Type::Unicode:
+      return sizeof(UnicodeConstant);
+    case Constant::Type::Integer:
+      return sizeof(IntegerConstant);
+    case Constant::Type::Float:
+      return sizeof(FloatConstant);
+    case Constant::Type::Long:
+      return sizeof(LongConstant);
+    case Constant::Type::Double:
+      return sizeof(DoubleConstant);
+    case Constant::Type::Class:
+      return sizeof(ClassConstant);
+    case Constant::Type::String:
+      return sizeof(StringConstant);
+    case Constant::Type::Field:
+      return sizeof(FieldConstant);
+    case Constant::Type::Method:
+      return sizeof(MethodConstant);
+    case Constant::Type::InterfaceMethod:
+      return sizeof(InterfaceMethodConstant);
+    case Constant::Type::Variable:
+      return sizeof(VariableConstant);
+    case Constant::Type::MethodHandle:
+      return sizeof(MethodHandleConstant);
+    case Constant::Type::MethodType:
+      return sizeof(MethodTypeConstant);
+    case Constant::Type::InvokeDynamic:
+      return sizeof(InvokeDynamicConstant);
+    default:
+      return sizeof(Constant);
+  }
+}
+
+void MeasureAttributes(const vector<shared_ptr<Attribute>>& attributes,
+                       ClassMemory& memory) {
+  memory.metadata += HeapSize(attributes);
+  for (const shared_ptr<Attribute>& attribute : attributes) {
+    if (auto code = dynamic_pointer_cast<CodeAttribute>(attribute)) {
+      memory.code += sizeof(CodeAttribute) + kControlBlockSize +
+                     HeapSize(code->bytes) + HeapSize(code->code) +
+                     HeapSize(code->exception_table) +
+                     HeapSize(code->handlers) + HeapSize(code->handler_ranges);
+      for (const HandlerRange& range : code->handler_ranges)
+        memory.code += HeapSize(range.handlers);
+      MeasureAttributes(code->attributes, memory);
+      continue;
+    }
+    memory.attributes += kControlBlockSize + HeapSize(attribute->bytes);
+    auto lines = dynamic_pointer_cast<LineNumberTableAttribute>(attribute);
+    if (lines) {
+      memory.attributes +=
+          sizeof(LineNumberTableAttribute) + HeapSize(lines->table);
+    } else if (dynamic_pointer_cast<SourceFileAttribute>(attribute)) {
+      memory.attributes += sizeof(SourceFileAttribute);
+    } else {
+      memory.attributes += sizeof(Attribute);
+    }
+  }
+}
+
+size_t HeapSize(const Layout& layout) {
+  return HeapSize(layout.references) + HeapSize(layout.gaps);
+}
+
+void SortBySize(vector<ClassMemory>& classes) {
+  std::stable_sort(classes.begin(), classes.end(),
+                   [](const ClassMemory& left, const ClassMemory& right) {
+                     return left.total() > right.total();
+                   });
+}
+
+}  // namespace
+
+ClassMemory MemoryAccounting::MeasureClass(const Class& main) {
+  ClassMemory memory;
+  memory.name = main.this_class->name->bytes;
+  memory.constant_pool += HeapSize(main.constant_pool);
+  for (const shared_ptr<Constant>& constant : main.constant_pool) {
+    memory.constant_pool += ConstantSize(*constant) + kControlBlockSize;
+    if (constant->tag == Constant::Type::Unicode)
+      memory.strings +=
+          HeapSize(static_cast<const UnicodeConstant&>(*constant).bytes);
+  }
+  memory.statics = main.static_layout.size;
+  memory.metadata += sizeof(Class) + HeapSize(main.interfaces) +
+                     HeapSize(main.fields) + HeapSize(main.methods) +
+                     HeapSize(main.instance_layout) +
+                     HeapSize(main.static_layout);
+  for (const Field& field : main.fields)
+    MeasureAttributes(field.attributes, memory);
+  for (const Method& method : main.methods)
+    MeasureAttributes(method.attributes, memory);
+  MeasureAttributes(main.attributes, memory);
+  return memory;
+}
+
+MemoryReport MemoryAccounting::MeasureTable(const ClassTable& classes) {
+  MemoryReport report;
+  for (const auto& entry : classes.classes())
+    report.classes.push_back(MeasureClass(*entry.second));
+  SortBySize(report.classes);
+  return report;
+}
+
+MemoryReport MemoryAccounting::MeasureIsolate(const Isolate& isolate) {
+  MemoryReport report;
+  report.isolate = true;
+  for (const auto& entry : isolate.classes().classes()) {
+    ClassMemory memory = MeasureClass(*entry.second);
+    memory.statics = isolate.StaticsSize(*entry.second);
+    report.classes.push_back(std::move(memory));
+  }
+  SortBySize(report.classes);
+  const auto& strings = isolate.strings();
+  report.interned = strings.bucket_count() * sizeof(void*);
+  for (const string& value : strings)
+    report.interned += kHashNodeSize + HeapSize(value);
+  return report;
+}
+
+void MemoryAccounting::PrintReport(ostream& os, const MemoryReport& report) {
+  const vector<ClassMemory>& classes = report.classes;
+  ClassMemory totals;
+  totals.name = "Total";
+  size_t width = totals.name.size();
+  for (const ClassMemory& memory : classes) {
+    width = std::max(width, memory.name.size());
+    totals.constant_pool += memory.constant_pool;
+    totals.strings += memory.strings;
+    totals.code += memory.code;
+    totals.attributes += memory.attributes;
+    totals.metadata += memory.metadata;
+    totals.statics += memory.statics;
+  }
+  const auto row = [&](const ClassMemory& memory) {
+    os << std::left << std::setw(width) << memory.name << std::right
+       << std::setw(10) << memory.total() << std::setw(10)
+       << memory.constant_pool << std::setw(10) << memory.strings
+       << std::setw(10) << memory.code << std::setw(12) << memory.attributes
+       << std::setw(10) << memory.metadata << std::setw(17) << memory.statics
+       << std::endl;
+  };
+  os << std::left << std::setw(width) << "Class" << std::right << std::setw(10)
+     << "Total" << std::setw(10) << "Constants" << std::setw(10) << "Strings"
+     << std::setw(10) << "Code" << std::setw(12) << "Attributes"
+     << std::setw(10) << "Metadata" << std::setw(17)
+     << (report.isolate ? "Statics" : "Statics/isolate") << std::endl;
+  for (const ClassMemory& memory : classes) row(memory);
+  row(totals);
+  if (report.isolate)
+    os << "Interned strings: " << report.interned << std::endl;
+}
+
+}  // namespace JVM
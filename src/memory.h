@@ -0,0 +1,51 @@
+#pragma once
+
+#include "class.h"
+#include "isolate.h"
+#include "utilities.h"
+
+namespace JVM {
+
+// Bytes of memory attributed to one class, by the kind of data that uses
+// them. Sizes include the heap allocations behind strings, vectors and
+// shared_ptr control blocks, not just the sizeof of each structure.
+struct ClassMemory {
+  string name;
+  size_t constant_pool = 0;  // Constant structures and the pool itself.
+  size_t strings = 0;        // Characters of Unicode constants.
+  size_t code = 0;           // Bytecode, exception tables and handler index.
+  size_t attributes = 0;     // All other attributes.
+  size_t metadata = 0;       // The class, its fields, methods and layouts.
+  size_t statics = 0;        // Static field storage; see MemoryReport.
+
+  size_t total() const {
+    return constant_pool + strings + code + attributes + metadata + statics;
+  }
+};
+
+struct MemoryReport {
+  vector<ClassMemory> classes;  // Largest first.
+  // Whether statics are what one isolate has allocated, rather than what
+  // every isolate allocates once it uses the class.
+  bool isolate = false;
+  size_t interned = 0;  // The isolate's intern table.
+};
+
+class MemoryAccounting {
+ public:
+  // The memory used by the metadata of a loaded class, with the static
+  // storage that each isolate using it will allocate.
+  static ClassMemory MeasureClass(const Class& main);
+
+  // The memory used by every class in the table, without any isolate.
+  static MemoryReport MeasureTable(const ClassTable& classes);
+
+  // The memory used by every class in the isolate's table, counting only the
+  // static storage the isolate has allocated, plus its intern table.
+  static MemoryReport MeasureIsolate(const Isolate& isolate);
+
+  // Print a table of the classes, followed by totals.
+  static void PrintReport(ostream& os, const MemoryReport& report);
+};
+
+}  // namespace JVM
@@ -289,7 +289,7 @@ void Parser::TraceConstants(Class& main) {
     if (!field.name) throw InvalidFormatError("Invalid constant pool entry.");
     field.type = dynamic_pointer_cast<UnicodeConstant>(pool[field.type_index]);
     if (!field.type) throw InvalidFormatError("Invalid constant pool entry.");
-    for (shared_ptr<Attribute> attribute : field.attributes) {
+    for (shared_ptr<Attribute>& attribute : field.attributes) {
       attribute = Parser::InterpretAttribute(attribute, pool);
     }
   }
@@ -300,11 +300,11 @@ void Parser::TraceConstants(Class& main) {
     method.type =
         dynamic_pointer_cast<UnicodeConstant>(pool[method.type_index]);
     if (!method.type) throw InvalidFormatError("Invalid constant pool entry.");
-    for (shared_ptr<Attribute> attribute : method.attributes) {
+    for (shared_ptr<Attribute>& attribute : method.attributes) {
       attribute = Parser::InterpretAttribute(attribute, pool);
     }
   }
-  for (shared_ptr<Attribute> attribute : main.attributes) {
+  for (shared_ptr<Attribute>& attribute : main.attributes) {
     attribute = Parser::InterpretAttribute(attribute, pool);
   }
 }
@@ -318,12 +318,47 @@ shared_ptr<Attribute> Parser::InterpretAttribute(
     auto attribute = make_shared<CodeAttribute>();
     attribute->name_index = name_index;
     attribute->name = name;
+    attribute->max_stack = ParseShort(source);
+    attribute->max_locals = ParseShort(source);
+    uint32_t code_length = ParseInteger(source);
+    for (uint32_t index = 0; index < code_length; ++index) {
+      attribute->code.push_back(ParseByte(source));
+    }
+    uint16_t exception_table_length = ParseShort(source);
+    for (uint16_t index = 0; index < exception_table_length; ++index) {
+      Exception exception;
+      exception.start_pc = ParseShort(source);
+      exception.end_pc = ParseShort(source);
+      exception.handler_pc = ParseShort(source);
+      exception.catch_type = ParseShort(source);
+      attribute->exception_table.push_back(exception);
+    }
+    uint16_t attributes_count = ParseShort(source);
+    for (uint16_t index = 0; index < attributes_count; ++index) {
+      // Only line numbers are used; anything else, such as a StackMapTable,
+      // is kept as it was read.
+      auto nested = ParseAttribute(source);
+      nested->name = dynamic_pointer_cast<UnicodeConstant>(
+          pool.at(nested->name_index));
+      if (!nested->name)
+        throw InvalidFormatError("Invalid constant pool entry.");
+      if (nested->name->bytes == "LineNumberTable")
+        nested = InterpretAttribute(nested, pool);
+      attribute->attributes.push_back(nested);
+    }
     return attribute;
   }
   if (name->bytes == "LineNumberTable") {
     auto attribute = make_shared<LineNumberTableAttribute>();
     attribute->name_index = name_index;
     attribute->name = name;
+    uint16_t table_length = ParseShort(source);
+    for (uint16_t index = 0; index < table_length; ++index) {
+      LineNumber line;
+      line.start_pc = ParseShort(source);
+      line.line_number = ParseShort(source);
+      attribute->table.push_back(line);
+    }
     return attribute;
   }
   if (name->bytes == "SourceFile") {
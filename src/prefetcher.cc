@@ -0,0 +1,126 @@
+#include "prefetcher.h"
+
+#include <algorithm>
+
+#include "loader.h"
+
+namespace JVM {
+
+ClassPrefetcher::ClassPrefetcher(const vector<string>& classpath,
+                                 size_t threads, size_t capacity)
+    : classpath_(classpath), capacity_(capacity) {
+  for (size_t index = 0; index < threads; ++index)
+    threads_.emplace_back(&ClassPrefetcher::Work, this);
+}
+
+ClassPrefetcher::~ClassPrefetcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  queued_.notify_all();
+  for (std::thread& thread : threads_) thread.join();
+}
+
+void ClassPrefetcher::Prefetch(const string& name) {
+  // Array classes are not loaded from the classpath.
+  if (name.empty() || name.front() == '[') return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.count(name)) return;
+    if (outstanding_ >= capacity_) {
+      ++stats_.skipped;
+      return;
+    }
+    entries_[name];
+    queue_.push_back(name);
+    ++outstanding_;
+  }
+  queued_.notify_one();
+}
+
+unique_ptr<Class> ClassPrefetcher::TakeClass(const string& name) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto entry = entries_.find(name);
+  if (entry == entries_.end()) {
+    ++stats_.misses;
+    entries_[name].done = true;
+    lock.unlock();
+    return LoadClass(name);
+  }
+  auto queued = std::find(queue_.begin(), queue_.end(), name);
+  if (queued != queue_.end()) {
+    // No thread has picked it up yet, so it is quicker to load it here.
+    queue_.erase(queued);
+    --outstanding_;
+    ++stats_.misses;
+    entry->second.done = true;
+    lock.unlock();
+    return LoadClass(name);
+  }
+  bool waited = !entry->second.done;
+  finished_.wait(lock, [&] { return entry->second.done; });
+  // A class that was not found, failed to parse or was already taken is
+  // a miss, whether or not a worker got to it first.
+  if (!entry->second.result) {
+    ++stats_.misses;
+    if (entry->second.error) std::rethrow_exception(entry->second.error);
+    return nullptr;
+  }
+  ++(waited ? stats_.waits : stats_.hits);
+  --outstanding_;
+  return std::move(entry->second.result);
+}
+
+PrefetchStats ClassPrefetcher::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+unique_ptr<Class> ClassPrefetcher::LoadClass(const string& name) {
+  for (const string& directory : classpath_) {
+    std::ifstream file(directory + '/' + name + ".class");
+    if (!file.is_open()) continue;
+    string data((std::istreambuf_iterator<char>(file)),
+                std::istreambuf_iterator<char>());
+    auto main = make_unique<Class>(ClassLoader::ParseClass(data));
+    for (const shared_ptr<Constant>& constant : main->constant_pool) {
+      if (constant->tag == Constant::Type::Class)
+        Prefetch(static_cast<const ClassConstant&>(*constant).name->bytes);
+    }
+    return main;
+  }
+  return nullptr;
+}
+
+void ClassPrefetcher::Work() {
+  while (true) {
+    string name;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      queued_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (stopping_) return;
+      name = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    Entry entry;
+    try {
+      entry.result = LoadClass(name);
+    } catch (...) {
+      entry.error = std::current_exception();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      entry.done = true;
+      // Only parsed classes are held until they are taken.
+      if (entry.result)
+        ++stats_.prefetched;
+      else
+        --outstanding_;
+      entries_[name] = std::move(entry);
+    }
+    finished_.notify_all();
+  }
+}
+
+}  // namespace JVM
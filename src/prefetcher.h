@@ -0,0 +1,77 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "class.h"
+#include "utilities.h"
+
+namespace JVM {
+
+struct PrefetchStats {
+  size_t hits = 0;        // Already parsed when asked for.
+  size_t waits = 0;       // Still being read or parsed when asked for.
+  size_t misses = 0;      // Loaded on the caller's thread, or not found.
+  size_t prefetched = 0;  // Found and parsed in the background.
+  size_t skipped = 0;     // Not queued because the prefetcher was full.
+};
+
+// Reads and parses classes from a classpath of directories on a pool of
+// background threads. Whenever a class is parsed, the classes named in its
+// constant pool are queued as well, so that by the time one of them is needed
+// it has usually been parsed already.
+//
+// Since references are followed transitively, at most capacity classes are
+// queued or parsed and waiting to be taken at any time. Further requests are
+// skipped until classes are taken, so memory is bounded however large the
+// classpath is; a skipped class is simply loaded on the caller's thread.
+class ClassPrefetcher {
+ public:
+  ClassPrefetcher(const vector<string>& classpath, size_t threads,
+                  size_t capacity);
+  ~ClassPrefetcher();
+
+  ClassPrefetcher(const ClassPrefetcher&) = delete;
+  ClassPrefetcher& operator=(const ClassPrefetcher&) = delete;
+
+  // Queue the class with the given internal name to be parsed, if it has not
+  // been already and there is room.
+  void Prefetch(const string& name);
+
+  // Hand over the parsed class, waiting for it if it is in progress, or
+  // loading it on the calling thread if no thread has started on it. Returns
+  // null if the class is not on the classpath or has already been taken, and
+  // rethrows any format error.
+  unique_ptr<Class> TakeClass(const string& name);
+
+  PrefetchStats stats() const;
+
+ private:
+  struct Entry {
+    bool done = false;
+    unique_ptr<Class> result;
+    std::exception_ptr error;
+  };
+
+  // Read and parse a class, and queue the classes it refers to.
+  unique_ptr<Class> LoadClass(const string& name);
+  void Work();
+
+  vector<string> classpath_;
+  size_t capacity_;
+  size_t outstanding_ = 0;  // Classes queued, or parsed and not yet taken.
+  vector<std::thread> threads_;
+  mutable std::mutex mutex_;
+  std::condition_variable queued_;
+  std::condition_variable finished_;
+  std::deque<string> queue_;
+  std::map<string, Entry> entries_;  // Every class queued or taken.
+  PrefetchStats stats_;
+  bool stopping_ = false;
+};
+
+}  // namespace JVM
@@ -0,0 +1,643 @@
+#include "translator.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <set>
+#include <sstream>
+
+#include "parser.h"
+
+namespace JVM {
+
+namespace {
+
+// Computational kinds of values: I (int and narrower), J, F, D, A (reference)
+// and V (void, for return types only).
+char Kind(char descriptor) {
+  switch (descriptor) {
+    case 'B':
+    case 'C':
+    case 'S':
+    case 'Z':
+    case 'I':
+      return 'I';
+    case 'J':
+    case 'F':
+    case 'D':
+    case 'V':
+      return descriptor;
+    case 'L':
+    case '[':
+      return 'A';
+    default:
+      throw InvalidFormatError("Invalid descriptor.");
+  }
+}
+
+string CType(char kind) {
+  switch (kind) {
+    case 'I':
+      return "int32_t";
+    case 'J':
+      return "int64_t";
+    case 'F':
+      return "float";
+    case 'D':
+      return "double";
+    case 'A':
+      return "void*";
+    default:
+      return "void";
+  }
+}
+
+// The type a field is stored as in its static block.
+string StorageType(char descriptor) {
+  switch (descriptor) {
+    case 'B':
+      return "int8_t";
+    case 'Z':
+      return "uint8_t";
+    case 'C':
+      return "uint16_t";
+    case 'S':
+      return "int16_t";
+    default:
+      return CType(Kind(descriptor));
+  }
+}
+
+bool IsWide(char kind) { return kind == 'J' || kind == 'D'; }
+
+// Split a method descriptor such as "(I[Ljava/lang/String;)V" into the kinds
+// of its arguments and of its result.
+void ParseMethodDescriptor(const string& descriptor, vector<char>& arguments,
+                           char& result) {
+  size_t index = 1;
+  if (descriptor.empty() || descriptor.front() != '(')
+    throw InvalidFormatError("Invalid method descriptor.");
+  while (index < descriptor.size() && descriptor[index] != ')') {
+    char first = descriptor[index];
+    while (index < descriptor.size() && descriptor[index] == '[') ++index;
+    if (index < descriptor.size() && descriptor[index] == 'L')
+      index = descriptor.find(';', index);
+    if (index >= descriptor.size())
+      throw InvalidFormatError("Invalid method descriptor.");
+    arguments.push_back(Kind(first));
+    ++index;
+  }
+  if (index + 1 >= descriptor.size())
+    throw InvalidFormatError("Invalid method descriptor.");
+  result = Kind(descriptor[index + 1]);
+}
+
+string Mangle(const string& name) {
+  string mangled;
+  for (char c : name)
+    mangled += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+  return mangled;
+}
+
+string Signature(const Class& main, size_t method_index) {
+  vector<char> arguments;
+  char result;
+  ParseMethodDescriptor(main.methods[method_index].type->bytes, arguments,
+                        result);
+  std::ostringstream os;
+  os << CType(result) << ' ' << Translator::FunctionName(main, method_index)
+     << "(uint8_t* statics";
+  for (size_t index = 0; index < arguments.size(); ++index)
+    os << ", " << CType(arguments[index]) << " a" << index;
+  os << ')';
+  return os.str();
+}
+
+UnsupportedBytecodeError UnsupportedOpcode(uint8_t opcode) {
+  std::ostringstream message;
+  message << "opcode 0x" << std::hex << std::setfill('0') << std::setw(2)
+          << static_cast<int>(opcode);
+  return UnsupportedBytecodeError(message.str());
+}
+
+// Number of bytes taken by the instruction with the given opcode, for the
+// instructions the translator understands.
+size_t InstructionLength(uint8_t opcode) {
+  switch (opcode) {
+    case 0x10:  // bipush
+    case 0x12:  // ldc
+    case 0x15:  // iload
+    case 0x16:  // lload
+    case 0x17:  // fload
+    case 0x18:  // dload
+    case 0x19:  // aload
+    case 0x36:  // istore
+    case 0x37:  // lstore
+    case 0x38:  // fstore
+    case 0x39:  // dstore
+    case 0x3a:  // astore
+      return 2;
+    case 0x11:  // sipush
+    case 0x13:  // ldc_w
+    case 0x14:  // ldc2_w
+    case 0x84:  // iinc
+    case 0xb2:  // getstatic
+    case 0xb3:  // putstatic
+    case 0xb8:  // invokestatic
+    case 0xc6:  // ifnull
+    case 0xc7:  // ifnonnull
+      return 3;
+    case 0xc8:  // goto_w
+      return 5;
+    default:
+      if (opcode >= 0x99 && opcode <= 0xa7) return 3;  // if<cond>, goto
+      if (opcode <= 0x0f) return 1;                    // Constants.
+      if (opcode >= 0x1a && opcode <= 0x2d) return 1;  // <t>load_<n>
+      if (opcode >= 0x3b && opcode <= 0x4e) return 1;  // <t>store_<n>
+      if (opcode >= 0x57 && opcode <= 0x59) return 1;  // pop, pop2, dup
+      if (opcode >= 0x60 && opcode <= 0x6b) return 1;  // add, sub, mul
+      if (opcode >= 0x74 && opcode <= 0x98) return 1;  // neg, bitwise, casts
+      if (opcode >= 0xac && opcode <= 0xb1) return 1;  // <t>return
+      throw UnsupportedOpcode(opcode);
+  }
+}
+
+class MethodTranslator {
+ public:
+  MethodTranslator(const Class& main, size_t method_index,
+                   const vector<bool>& compiled)
+      : main_(main),
+        method_index_(method_index),
+        method_(main.methods[method_index]),
+        compiled_(compiled) {}
+
+  string Translate();
+
+ private:
+  struct Value {
+    char kind;
+    string name;
+  };
+
+  uint8_t U1(size_t pc) const;
+  uint16_t U2(size_t pc) const { return U1(pc) << 8 | U1(pc + 1); }
+  int32_t S4(size_t pc) const {
+    return static_cast<int32_t>(static_cast<uint32_t>(U2(pc)) << 16 |
+                                U2(pc + 2));
+  }
+
+  void Declare(const string& type, const string& name);
+  void Push(char kind, const string& expression);
+  Value Pop(char kind);
+  Value Pop();
+  string Local(uint16_t index, char kind);
+  void Binary(char kind, const string& function);
+  void Convert(char from, char to);
+  void Jump(size_t target, const string& condition);
+  void Translate(size_t pc, uint8_t opcode);
+  const Field& StaticField(uint16_t index);
+  size_t StaticMethod(uint16_t index);
+
+  const Class& main_;
+  size_t method_index_;
+  const Method& method_;
+  const vector<bool>& compiled_;
+  vector<Value> stack_;
+  size_t temporaries_ = 0;
+  std::set<string> declared_;
+  std::ostringstream declarations_;
+  std::ostringstream body_;
+};
+
+uint8_t MethodTranslator::U1(size_t pc) const {
+  if (pc >= method_.code->code.size())
+    throw InvalidFormatError("The code must not be truncated.");
+  return method_.code->code[pc];
+}
+
+void MethodTranslator::Declare(const string& type, const string& name) {
+  // Everything is declared up front, since a goto must not jump over an
+  // initialisation.
+  if (declared_.insert(name).second)
+    declarations_ << "  " << type << ' ' << name << "{};" << std::endl;
+}
+
+void MethodTranslator::Push(char kind, const string& expression) {
+  string name = "v" + std::to_string(temporaries_++);
+  Declare(CType(kind), name);
+  body_ << "  " << name << " = " << expression << ';' << std::endl;
+  stack_.push_back({kind, name});
+}
+
+MethodTranslator::Value MethodTranslator::Pop(char kind) {
+  Value value = Pop();
+  if (value.kind != kind)
+    throw InvalidFormatError("The operand stack has the wrong type.");
+  return value;
+}
+
+MethodTranslator::Value MethodTranslator::Pop() {
+  if (stack_.empty())
+    throw InvalidFormatError("The operand stack must not underflow.");
+  Value value = stack_.back();
+  stack_.pop_back();
+  return value;
+}
+
+string MethodTranslator::Local(uint16_t index, char kind) {
+  // A slot can hold values of different kinds over the life of the method, so
+  // each kind gets its own variable.
+  string name = "l" + std::to_string(index) + '_' + kind;
+  Declare(CType(kind), name);
+  return name;
+}
+
+void MethodTranslator::Binary(char kind, const string& function) {
+  Value right = Pop(kind);
+  Value left = Pop(kind);
+  Push(kind, function + '<' + CType(kind) + ">(" + left.name + ", " +
+                 right.name + ')');
+}
+
+void MethodTranslator::Convert(char from, char to) {
+  Value value = Pop(from);
+  Push(to, "JavaConvert<" + CType(to) + ">(" + value.name + ')');
+}
+
+void MethodTranslator::Jump(size_t target, const string& condition) {
+  if (!stack_.empty())
+    throw UnsupportedBytecodeError("values on the stack across a branch");
+  if (target >= method_.code->code.size())
+    throw InvalidFormatError("Invalid branch target.");
+  body_ << "  ";
+  if (!condition.empty()) body_ << "if (" << condition << ") ";
+  body_ << "goto pc" << target << ';' << std::endl;
+}
+
+const Field& MethodTranslator::StaticField(uint16_t index) {
+  auto constant =
+      dynamic_pointer_cast<FieldConstant>(main_.constant_pool.at(index));
+  if (!constant) throw InvalidFormatError("Invalid constant pool entry.");
+  if (constant->class_->name->bytes != main_.this_class->name->bytes)
+    throw UnsupportedBytecodeError("static field of another class");
+  for (const Field& field : main_.fields) {
+    if ((field.access_flags & kAccStatic) &&
+        field.name->bytes == constant->variable->name->bytes &&
+        field.type->bytes == constant->variable->type->bytes)
+      return field;
+  }
+  throw UnsupportedBytecodeError("inherited static field");
+}
+
+size_t MethodTranslator::StaticMethod(uint16_t index) {
+  auto constant =
+      dynamic_pointer_cast<MethodConstant>(main_.constant_pool.at(index));
+  if (!constant) throw UnsupportedBytecodeError("interface method call");
+  if (constant->class_->name->bytes != main_.this_class->name->bytes)
+    throw UnsupportedBytecodeError("call to another class");
+  for (size_t method = 0; method < main_.methods.size(); ++method) {
+    if (main_.methods[method].name->bytes == constant->variable->name->bytes &&
+        main_.methods[method].type->bytes == constant->variable->type->bytes) {
+      if (!compiled_[method])
+        throw UnsupportedBytecodeError("call to an untranslated method");
+      return method;
+    }
+  }
+  throw UnsupportedBytecodeError("inherited static method");
+}
+
+void MethodTranslator::Translate(size_t pc, uint8_t opcode) {
+  static const char kKinds[] = {'I', 'J', 'F', 'D', 'A'};
+  if (opcode == 0x00) return;  // nop
+  if (opcode == 0x01) return Push('A', "nullptr");
+  if (opcode >= 0x02 && opcode <= 0x08)
+    return Push('I', std::to_string(opcode - 0x03));
+  if (opcode >= 0x09 && opcode <= 0x0a)
+    return Push('J', std::to_string(opcode - 0x09));
+  if (opcode >= 0x0b && opcode <= 0x0d)
+    return Push('F', std::to_string(opcode - 0x0b) + ".0f");
+  if (opcode >= 0x0e && opcode <= 0x0f)
+    return Push('D', std::to_string(opcode - 0x0e) + ".0");
+  if (opcode >= 0x15 && opcode <= 0x19) {
+    char kind = kKinds[opcode - 0x15];
+    return Push(kind, Local(U1(pc + 1), kind));
+  }
+  if (opcode >= 0x1a && opcode <= 0x2d) {
+    char kind = kKinds[(opcode - 0x1a) / 4];
+    return Push(kind, Local((opcode - 0x1a) % 4, kind));
+  }
+  if (opcode >= 0x36 && opcode <= 0x3a) {
+    char kind = kKinds[opcode - 0x36];
+    body_ << "  " << Local(U1(pc + 1), kind) << " = " << Pop(kind).name << ';'
+          << std::endl;
+    return;
+  }
+  if (opcode >= 0x3b && opcode <= 0x4e) {
+    char kind = kKinds[(opcode - 0x3b) / 4];
+    body_ << "  " << Local((opcode - 0x3b) % 4, kind) << " = "
+          << Pop(kind).name << ';' << std::endl;
+    return;
+  }
+  if (opcode >= 0x60 && opcode <= 0x6b) {
+    static const char* kFunctions[] = {"JavaAdd", "JavaSub", "JavaMul"};
+    return Binary(kKinds[(opcode - 0x60) % 4], kFunctions[(opcode - 0x60) / 4]);
+  }
+  if (opcode >= 0x74 && opcode <= 0x77) {
+    char kind = kKinds[opcode - 0x74];
+    Value value = Pop(kind);
+    return Push(kind, "JavaNeg<" + CType(kind) + ">(" + value.name + ')');
+  }
+  if (opcode >= 0x78 && opcode <= 0x7d) {
+    static const char* kFunctions[] = {"JavaShl", "JavaShr", "JavaUshr"};
+    char kind = kKinds[(opcode - 0x78) % 2];
+    Value distance = Pop('I');
+    Value value = Pop(kind);
+    return Push(kind, string(kFunctions[(opcode - 0x78) / 2]) + '<' +
+                          CType(kind) + ">(" + value.name + ", " +
+                          distance.name + ')');
+  }
+  if (opcode >= 0x7e && opcode <= 0x83) {
+    static const char kOperators[] = {'&', '|', '^'};
+    char kind = kKinds[(opcode - 0x7e) % 2];
+    Value right = Pop(kind);
+    Value left = Pop(kind);
+    return Push(kind, left.name + ' ' + kOperators[(opcode - 0x7e) / 2] + ' ' +
+                          right.name);
+  }
+  if (opcode >= 0x85 && opcode <= 0x90) {
+    static const char kTargets[][3] = {{'J', 'F', 'D'}, {'I', 'F', 'D'},
+                                       {'I', 'J', 'D'}, {'I', 'J', 'F'}};
+    int from = (opcode - 0x85) / 3;
+    return Convert(kKinds[from], kTargets[from][(opcode - 0x85) % 3]);
+  }
+  if (opcode >= 0x91 && opcode <= 0x93) {
+    static const char* kTypes[] = {"int8_t", "uint16_t", "int16_t"};
+    Value value = Pop('I');
+    return Push('I', string("static_cast<int32_t>(static_cast<") +
+                         kTypes[opcode - 0x91] + ">(" + value.name + "))");
+  }
+  if (opcode >= 0x94 && opcode <= 0x98) {
+    char kind = opcode == 0x94 ? 'J' : opcode <= 0x96 ? 'F' : 'D';
+    Value right = Pop(kind);
+    Value left = Pop(kind);
+    string nan = opcode == 0x95 || opcode == 0x97 ? "-1" : "1";
+    return Push('I', "JavaCompare<" + CType(kind) + ">(" + left.name + ", " +
+                         right.name + ", " + nan + ')');
+  }
+  if (opcode >= 0x99 && opcode <= 0xa6) {
+    static const char* kConditions[] = {"==", "!=", "<", ">=", ">", "<="};
+    size_t target = pc + static_cast<int16_t>(U2(pc + 1));
+    if (opcode <= 0x9e) {
+      Value value = Pop('I');
+      return Jump(target,
+                  value.name + ' ' + kConditions[opcode - 0x99] + " 0");
+    }
+    char kind = opcode <= 0xa4 ? 'I' : 'A';
+    Value right = Pop(kind);
+    Value left = Pop(kind);
+    return Jump(target, left.name + ' ' + kConditions[(opcode - 0x9f) % 6] +
+                            ' ' + right.name);
+  }
+  if (opcode >= 0xac && opcode <= 0xb0) {
+    char kind = kKinds[opcode - 0xac];
+    body_ << "  return " << Pop(kind).name << ';' << std::endl;
+    stack_.clear();
+    return;
+  }
+  switch (opcode) {
+    case 0x10:  // bipush
+      return Push('I', std::to_string(static_cast<int8_t>(U1(pc + 1))));
+    case 0x11:  // sipush
+      return Push('I', std::to_string(static_cast<int16_t>(U2(pc + 1))));
+    case 0x12:    // ldc
+    case 0x13:    // ldc_w
+    case 0x14: {  // ldc2_w
+      uint16_t index = opcode == 0x12 ? U1(pc + 1) : U2(pc + 1);
+      const auto& constant = main_.constant_pool.at(index);
+      std::ostringstream os;
+      os << std::hex << "0x";
+      switch (constant->tag) {
+        case Constant::Type::Integer:
+          os << static_cast<const IntegerConstant&>(*constant).bytes;
+          return Push('I', "static_cast<int32_t>(" + os.str() + "u)");
+        case Constant::Type::Float:
+          os << static_cast<const FloatConstant&>(*constant).bytes;
+          return Push('F', "FromBits<float>(" + os.str() + "u)");
+        case Constant::Type::Long:
+        case Constant::Type::Double: {
+          // Long and double constants share a layout.
+          const auto& wide = static_cast<const LongConstant&>(*constant);
+          os << std::setfill('0') << wide.high_bytes << std::setw(8)
+             << wide.low_bytes << "ull";
+          if (constant->tag == Constant::Type::Long)
+            return Push('J', "static_cast<int64_t>(" + os.str() + ')');
+          return Push('D', "FromBits<double>(" + os.str() + ')');
+        }
+        default:
+          throw UnsupportedBytecodeError("ldc of an object");
+      }
+    }
+    case 0x57:  // pop
+      if (IsWide(Pop().kind))
+        throw InvalidFormatError("The operand stack has the wrong type.");
+      return;
+    case 0x58:  // pop2
+      if (!IsWide(Pop().kind) && IsWide(Pop().kind))
+        throw InvalidFormatError("The operand stack has the wrong type.");
+      return;
+    case 0x59: {  // dup
+      Value value = Pop();
+      if (IsWide(value.kind))
+        throw InvalidFormatError("The operand stack has the wrong type.");
+      stack_.push_back(value);
+      stack_.push_back(value);
+      return;
+    }
+    case 0x84: {  // iinc
+      string local = Local(U1(pc + 1), 'I');
+      body_ << "  " << local << " = JavaAdd<int32_t>(" << local << ", "
+            << static_cast<int>(static_cast<int8_t>(U1(pc + 2))) << ");"
+            << std::endl;
+      return;
+    }
+    case 0xa7:  // goto
+      Jump(pc + static_cast<int16_t>(U2(pc + 1)), "");
+      stack_.clear();
+      return;
+    case 0xc8:  // goto_w
+      Jump(pc + S4(pc + 1), "");
+      stack_.clear();
+      return;
+    case 0xb1:  // return
+      body_ << "  return;" << std::endl;
+      stack_.clear();
+      return;
+    case 0xb2: {  // getstatic
+      const Field& field = StaticField(U2(pc + 1));
+      char descriptor = field.type->bytes.front();
+      char kind = Kind(descriptor);
+      return Push(kind, "static_cast<" + CType(kind) + ">(LoadStatic<" +
+                            StorageType(descriptor) + ">(statics, " +
+                            std::to_string(field.offset) + "))");
+    }
+    case 0xb3: {  // putstatic
+      const Field& field = StaticField(U2(pc + 1));
+      char descriptor = field.type->bytes.front();
+      string type = StorageType(descriptor);
+      body_ << "  StoreStatic<" << type << ">(statics, " << field.offset
+            << ", static_cast<" << type << ">(" << Pop(Kind(descriptor)).name
+            << "));" << std::endl;
+      return;
+    }
+    case 0xb8: {  // invokestatic
+      size_t callee = StaticMethod(U2(pc + 1));
+      vector<char> arguments;
+      char result;
+      ParseMethodDescriptor(main_.methods[callee].type->bytes, arguments,
+                            result);
+      vector<string> names(arguments.size());
+      for (size_t index = arguments.size(); index-- > 0;)
+        names[index] = Pop(arguments[index]).name;
+      string call = Translator::FunctionName(main_, callee) + "(statics";
+      for (const string& name : names) call += ", " + name;
+      call += ')';
+      if (result != 'V') return Push(result, call);
+      body_ << "  " << call << ';' << std::endl;
+      return;
+    }
+    case 0xc6:    // ifnull
+    case 0xc7: {  // ifnonnull
+      Value value = Pop('A');
+      return Jump(pc + static_cast<int16_t>(U2(pc + 1)),
+                  value.name + (opcode == 0xc6 ? " == " : " != ") + "nullptr");
+    }
+    default:
+      throw UnsupportedOpcode(opcode);
+  }
+}
+
+string MethodTranslator::Translate() {
+  if (!(method_.access_flags & kAccStatic))
+    throw UnsupportedBytecodeError("instance method");
+  if (!method_.code) throw UnsupportedBytecodeError("method without code");
+  const vector<uint8_t>& code = method_.code->code;
+  if (!method_.code->handlers.empty())
+    throw UnsupportedBytecodeError("exception handlers");
+
+  // Find the branch targets, which become labels. Each must be the start of
+  // an instruction, or the goto would land in the middle of one.
+  std::set<size_t> starts;
+  std::set<size_t> targets;
+  for (size_t pc = 0; pc < code.size(); pc += InstructionLength(code[pc])) {
+    uint8_t opcode = code[pc];
+    starts.insert(pc);
+    if ((opcode >= 0x99 && opcode <= 0xa7) || opcode == 0xc6 || opcode == 0xc7)
+      targets.insert(pc + static_cast<int16_t>(U2(pc + 1)));
+    if (opcode == 0xc8) targets.insert(pc + S4(pc + 1));
+  }
+  for (size_t target : targets) {
+    if (!starts.count(target))
+      throw InvalidFormatError("Invalid branch target.");
+  }
+
+  vector<char> arguments;
+  char result;
+  ParseMethodDescriptor(method_.type->bytes, arguments, result);
+  uint16_t slot = 0;
+  for (size_t index = 0; index < arguments.size(); ++index) {
+    body_ << "  " << Local(slot, arguments[index]) << " = a" << index << ';'
+          << std::endl;
+    slot += IsWide(arguments[index]) ? 2 : 1;
+  }
+
+  for (size_t pc = 0; pc < code.size(); pc += InstructionLength(code[pc])) {
+    if (targets.count(pc)) {
+      if (!stack_.empty())
+        throw UnsupportedBytecodeError("values on the stack across a branch");
+      body_ << "pc" << pc << ':' << std::endl;
+    }
+    Translate(pc, code[pc]);
+  }
+
+  std::ostringstream os;
+  os << Signature(main_, method_index_) << " {" << std::endl;
+  os << "  (void)statics;" << std::endl;
+  os << declarations_.str() << body_.str() << '}' << std::endl;
+  return os.str();
+}
+
+}  // namespace
+
+string Translator::FunctionName(const Class& main, size_t method_index) {
+  return Mangle(main.this_class->name->bytes) + "__" +
+         Mangle(main.methods[method_index].name->bytes) + '_' +
+         std::to_string(method_index);
+}
+
+string Translator::TranslateMethod(const Class& main, size_t method_index,
+                                   const vector<bool>& compiled) {
+  return MethodTranslator(main, method_index, compiled).Translate();
+}
+
+string Translator::TranslateClass(const Class& main) {
+  // Start by assuming every method can be compiled, and drop methods until
+  // none of the remaining ones calls a method that was dropped.
+  vector<bool> compiled(main.methods.size(), true);
+  vector<string> sources(main.methods.size());
+  vector<string> reasons(main.methods.size());
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t index = 0; index < main.methods.size(); ++index) {
+      if (!compiled[index]) continue;
+      try {
+        sources[index] = TranslateMethod(main, index, compiled);
+      } catch (const UnsupportedBytecodeError& error) {
+        compiled[index] = false;
+        reasons[index] = error.what();
+        changed = true;
+      }
+    }
+  }
+
+  const string& class_name = main.this_class->name->bytes;
+  std::ostringstream os;
+  os << "// Generated by the aot tool from " << class_name
+     << ".class. Do not edit." << std::endl;
+  os << std::endl << "#include \"src/compiled.h\"" << std::endl;
+  os << std::endl << "namespace {" << std::endl;
+  os << std::endl << "using namespace JVM;" << std::endl << std::endl;
+  for (size_t index = 0; index < main.methods.size(); ++index) {
+    const Method& method = main.methods[index];
+    if (!compiled[index]) {
+      os << "// " << class_name << '.' << method.name->bytes
+         << method.type->bytes << " is not translated: " << reasons[index]
+         << std::endl;
+    } else {
+      os << Signature(main, index) << ';' << std::endl;
+    }
+  }
+  for (size_t index = 0; index < main.methods.size(); ++index) {
+    if (compiled[index]) os << std::endl << sources[index];
+  }
+  if (std::count(compiled.begin(), compiled.end(), true) > 0) {
+    os << std::endl << "const CompiledMethod kMethods[] = {" << std::endl;
+    for (size_t index = 0; index < main.methods.size(); ++index) {
+      if (!compiled[index]) continue;
+      const Method& method = main.methods[index];
+      os << "    {\"" << class_name << "\", \"" << method.name->bytes
+         << "\", \"" << method.type->bytes
+         << "\", reinterpret_cast<void (*)()>(&"
+         << FunctionName(main, index) << ")}," << std::endl;
+    }
+    os << "};" << std::endl << std::endl;
+    os << "[[maybe_unused]] const bool kRegistered = CompiledCode::Register("
+       << std::endl
+       << "    kMethods, sizeof(kMethods) / sizeof(kMethods[0]));"
+       << std::endl;
+  }
+  os << std::endl << "}  // namespace" << std::endl;
+  return os.str();
+}
+
+}  // namespace JVM
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "class.h"
+#include "utilities.h"
+
+namespace JVM {
+
+struct UnsupportedBytecodeError : public std::runtime_error {
+  UnsupportedBytecodeError(const string& message)
+      : runtime_error("Unsupported Bytecode: " + message) {}
+};
+
+class Translator {
+ public:
+  // Translate the methods of a linked class into a C++ source file that
+  // registers them with CompiledCode when it is linked into a binary. Methods
+  // that cannot be translated are left out, with a comment saying why.
+  static string TranslateClass(const Class& main);
+
+  // Translate a single method into the definition of a C++ function. The
+  // operand stack is converted into single-assignment locals, one for every
+  // value pushed. Calls are only allowed to methods in the compiled set.
+  // Throws UnsupportedBytecodeError if the method cannot be translated.
+  static string TranslateMethod(const Class& main, size_t method_index,
+                                const vector<bool>& compiled);
+
+  // The name of the C++ function generated for a method.
+  static string FunctionName(const Class& main, size_t method_index);
+};
+
+}  // namespace JVM
@@ -0,0 +1,102 @@
+#include "unwinder.h"
+
+#include <algorithm>
+
+namespace JVM {
+
+vector<StackTraceElement> StackTrace::Symbolize() const {
+  vector<StackTraceElement> elements;
+  for (const Frame& frame : frames_) {
+    StackTraceElement element;
+    element.class_name = frame.class_->this_class->name->bytes;
+    element.method_name = frame.method->name->bytes;
+    element.file = Unwinder::FindSourceFile(*frame.class_);
+    element.line = frame.method->code
+                       ? Unwinder::FindLineNumber(*frame.method->code, frame.pc)
+                       : -1;
+    elements.push_back(std::move(element));
+  }
+  return elements;
+}
+
+ostream& operator<<(ostream& os, const StackTrace& trace) {
+  for (const StackTraceElement& element : trace.Symbolize()) {
+    string class_name = element.class_name;
+    std::replace(class_name.begin(), class_name.end(), '/', '.');
+    os << '\t' << "at " << class_name << '.' << element.method_name << '(';
+    if (element.file.empty()) {
+      os << "Unknown Source";
+    } else {
+      os << element.file;
+      if (element.line >= 0) os << ':' << element.line;
+    }
+    os << ')' << std::endl;
+  }
+  return os;
+}
+
+const Handler* Unwinder::FindHandler(const CodeAttribute& code, uint16_t pc,
+                                     const Class& thrown) {
+  const auto& ranges = code.handler_ranges;
+  auto range = std::upper_bound(
+      ranges.begin(), ranges.end(), pc,
+      [](uint16_t pc, const HandlerRange& range) {
+        return pc < range.start_pc;
+      });
+  if (range == ranges.begin()) return nullptr;
+  --range;
+  if (pc >= range->end_pc) return nullptr;
+  for (uint16_t index : range->handlers) {
+    const Handler& handler = code.handlers[index];
+    if (!handler.catch_type) return &handler;
+    const Class* catch_class =
+        handler.catch_class.load(std::memory_order_acquire);
+    if (!catch_class) continue;
+    for (const Class* main = &thrown; main; main = main->super) {
+      if (main == catch_class) return &handler;
+    }
+  }
+  return nullptr;
+}
+
+bool Unwinder::Unwind(vector<Frame>& frames, const Class& thrown) {
+  while (!frames.empty()) {
+    Frame& frame = frames.back();
+    if (frame.method->code) {
+      const Handler* handler =
+          FindHandler(*frame.method->code, frame.pc, thrown);
+      if (handler) {
+        frame.pc = handler->handler_pc;
+        return true;
+      }
+    }
+    frames.pop_back();
+  }
+  return false;
+}
+
+int Unwinder::FindLineNumber(const CodeAttribute& code, uint16_t pc) {
+  int line = -1;
+  uint16_t best_pc = 0;
+  for (const shared_ptr<Attribute>& attribute : code.attributes) {
+    auto table = dynamic_pointer_cast<LineNumberTableAttribute>(attribute);
+    if (!table) continue;
+    for (const auto& entry : table->table) {
+      if (entry.start_pc <= pc && (line < 0 || entry.start_pc >= best_pc)) {
+        best_pc = entry.start_pc;
+        line = entry.line_number;
+      }
+    }
+  }
+  return line;
+}
+
+string Unwinder::FindSourceFile(const Class& main) {
+  for (const shared_ptr<Attribute>& attribute : main.attributes) {
+    auto source = dynamic_pointer_cast<SourceFileAttribute>(attribute);
+    if (source && source->file) return source->file->bytes;
+  }
+  return "";
+}
+
+}  // namespace JVM
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "class.h"
+#include "utilities.h"
+
+namespace JVM {
+
+// A single activation on a thread's call stack.
+struct Frame {
+  const Class* class_;
+  const Method* method;
+  uint16_t pc;
+};
+
+struct StackTraceElement {
+  string class_name;
+  string method_name;
+  string file;  // Empty if the class has no SourceFile attribute.
+  int line;     // Negative if the method has no LineNumberTable.
+};
+
+// The stack trace of a thrown exception. Only the method and pc of each frame
+// are captured when the exception is created; file names and line numbers are
+// looked up when the trace is actually requested or printed.
+class StackTrace {
+ public:
+  StackTrace() = default;
+
+  explicit StackTrace(const vector<Frame>& frames)
+      : frames_(frames.rbegin(), frames.rend()) {}
+
+  const vector<Frame>& frames() const { return frames_; }
+
+  // Resolve the captured frames, innermost first.
+  vector<StackTraceElement> Symbolize() const;
+
+  friend ostream& operator<<(ostream& os, const StackTrace& trace);
+
+ private:
+  vector<Frame> frames_;  // Innermost first.
+};
+
+class Unwinder {
+ public:
+  // The handler selected for an exception of class thrown at the given pc, or
+  // null if the exception propagates out of the method. Catch types are
+  // matched by walking the superclass pointers of thrown.
+  static const Handler* FindHandler(const CodeAttribute& code, uint16_t pc,
+                                    const Class& thrown);
+
+  // Pop frames off the top of the stack until one has a handler for the
+  // exception, and point its pc at the handler. Returns false, leaving the
+  // stack empty, if the exception is uncaught.
+  static bool Unwind(vector<Frame>& frames, const Class& thrown);
+
+  // The source line containing the pc, or -1 if it is not known.
+  static int FindLineNumber(const CodeAttribute& code, uint16_t pc);
+
+  // The name of the file the class was compiled from, or empty if not known.
+  static string FindSourceFile(const Class& main);
+};
+
+}  // namespace JVM
@@ -0,0 +1,16 @@
+class Catch {
+    static int field;
+
+    static void fail() {
+        throw new IllegalStateException();
+    }
+
+    public static void main(String args[]) {
+        try {
+            fail();
+        } catch (IllegalStateException e) {
+            field = 1;
+        }
+        field = 2;
+    }
+}
@@ -0,0 +1,9 @@
+class Loop {
+    static int sum;
+
+    static void run() {
+        for (int i = 0; i < 10; ++i) {
+            sum += i;
+        }
+    }
+}